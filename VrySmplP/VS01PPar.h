@@ -0,0 +1,478 @@
+/*--------------------------------------------------------------------------*/
+/*----------------------- File VS01PPar.h ----------------------------------*/
+/*--------------------------------------------------------------------------*/
+/** @file
+ *
+ * Parallel drivers for the VerySimple01Problem: enumerating the k best
+ * solutions of many independent instances at once, or those of a single
+ * huge instance, using all the cores of the machine.
+ *
+ * \version 1.00
+ *
+ * \date 16 - 10 - 2026
+ */
+
+/*--------------------------------------------------------------------------*/
+/*--------------------------------------------------------------------------*/
+/*----------------------------- DEFINITIONS --------------------------------*/
+/*--------------------------------------------------------------------------*/
+/*--------------------------------------------------------------------------*/
+
+#ifndef __VS01PPar
+ #define __VS01PPar      // self-identification - endif at the end of the file
+
+/*--------------------------------------------------------------------------*/
+/*--------------------------- INCLUDES -------------------------------------*/
+/*--------------------------------------------------------------------------*/
+
+#include "VrySmplP.h"
+
+/*--------------------------------------------------------------------------*/
+/*------------------------ NAMESPACE and USINGS ----------------------------*/
+/*--------------------------------------------------------------------------*/
+
+namespace VS01P_di_unipi_it
+{
+
+/*--------------------------------------------------------------------------*/
+/*-------------------------- CLASS VS01PBatchT -----------------------------*/
+/*--------------------------------------------------------------------------*/
+/** Solves many independent VS01P with the same number n of variables, and
+    enumerates the k best solutions of each of them, in parallel.
+
+    There is one worker thread per core (or as many as asked), each owning a
+    VerySimple01ProblemT that it uses for all the instances it is given, so
+    that Q and the enumeration tree are allocated once per worker (by the
+    worker itself) and then reused. The instances are initially split among
+    the workers in contiguous ranges; a worker that has exhausted its range
+    steals the second half of what remains of the range of another one, so
+    that the load is balanced even if some instances are much harder than
+    others (e.g., because of ties). Since the instances share nothing, this
+    scales with the number of cores, up to the memory bandwidth.
+
+    The threads only live during a call to Solve(), while the solvers (and
+    their memory) persist across the calls. */
+
+template< class Wght = double , class Indx = unsigned int ,
+	  class ZrOn = double >
+class VS01PBatchT : public VerySimple01ProblemBase
+{
+/*--------------------------------------------------------------------------*/
+/*----------------------- PUBLIC PART OF THE CLASS -------------------------*/
+/*--------------------------------------------------------------------------*/
+
+ public:
+
+/*--------------------------------------------------------------------------*/
+/*---------------------------- PUBLIC TYPES --------------------------------*/
+/*--------------------------------------------------------------------------*/
+/** @name Public Types
+    @{ */
+
+   typedef VerySimple01ProblemT< Wght , Indx , ZrOn > Solver;
+
+/**< The class of the solvers used by the workers. */
+
+   typedef typename Solver::Weight  Weight;
+   typedef typename Solver::Index   Index;
+   typedef typename Solver::ZeroOne ZeroOne;
+
+/**< The same as in VerySimple01ProblemT. */
+
+/*@} -----------------------------------------------------------------------*/
+/*--------------------- PUBLIC METHODS OF THE CLASS ------------------------*/
+/*--------------------------------------------------------------------------*/
+/*---------------------------- CONSTRUCTOR ---------------------------------*/
+/*--------------------------------------------------------------------------*/
+/** @name Constructor
+    @{ */
+
+   VS01PBatchT( Index n , unsigned int nthr = 0 );
+
+/**< Constructor of the class. The parameter "n" is the number of variables
+   of all the VS01P, "nthr" is the number of worker threads: 0 means one per
+   core, as reported by the system. */
+
+/*@} -----------------------------------------------------------------------*/
+/*-------------------------- OTHER INITIALIZATIONS -------------------------*/
+/*--------------------------------------------------------------------------*/
+/** @name Other initializations
+    @{ */
+
+   void SetQueue( QueueType qt );
+
+/**< Set the priority queue used by all the workers [see
+   VerySimple01ProblemT::SetQueue()]. */
+
+/*--------------------------------------------------------------------------*/
+
+   void SetGap( Weight gap );
+
+/**< Only enumerate, in each instance, the solutions with value at least
+   the optimal one of that instance minus gap [see
+   VerySimple01ProblemT::SetGap()]; a negative gap, the default, means no
+   restriction. */
+
+/*@} -----------------------------------------------------------------------*/
+/*---------------------- METHODS FOR SOLVING THE PROBLEMS ------------------*/
+/*--------------------------------------------------------------------------*/
+/** @name Solving the problems
+    @{ */
+
+   void Solve( unsigned int m , const Weight *W , Index k , Weight *V ,
+	       ZeroOne *X = 0 , Index *NS = 0 );
+
+/**< Enumerate the k best solutions of m instances of VS01P. The weights of
+   the i-th instance (i = 0, ..., m - 1) are the n elements of W starting
+   from i * n, i.e., W is an m x n matrix stored by rows. All the output
+   goes to vectors preallocated by the caller, at fixed positions, so the
+   workers never have to synchronize to write it:
+
+   - the values of the solutions of the i-th instance are written, in
+     nonincreasing order, in the k positions of V starting from i * k;
+
+   - if X is not 0, the solutions of the i-th instance are written in the
+     k * n positions of X starting from i * k * n, as in
+     VerySimple01ProblemT::GetNextK();
+
+   - if NS is not 0, NS[ i ] is the number of solutions actually produced
+     for the i-th instance, which is less than k if k > 2^n, or if there
+     are less than k solutions within the gap [see SetGap()]; the positions
+     of V and X after them are left untouched.
+
+   If any of the instances throws an exception, the workers stop as soon as
+   possible and the (first) exception is thrown again by Solve(). */
+
+/*@} -----------------------------------------------------------------------*/
+/*------------------- METHODS FOR READING THE DATA -------------------------*/
+/*--------------------------------------------------------------------------*/
+/** @name Reading the data of the class
+    @{ */
+
+   inline Index Getn( void ) const;
+
+   inline unsigned int GetNThr( void ) const;
+
+/* Getn() returns the number of variables, GetNThr() the number of worker
+   threads. */
+
+/*@} -----------------------------------------------------------------------*/
+/*------------------------------ DESTRUCTOR --------------------------------*/
+/*--------------------------------------------------------------------------*/
+/** @name Destructor
+    @{ */
+
+   ~VS01PBatchT();
+
+/*@} -----------------------------------------------------------------------*/
+/*-------------------- PRIVATE PART OF THE CLASS ---------------------------*/
+/*--------------------------------------------------------------------------*/
+
+ private:
+
+/*--------------------------------------------------------------------------*/
+/*-------------------------- PRIVATE METHODS -------------------------------*/
+/*--------------------------------------------------------------------------*/
+
+   void Worker( unsigned int t , const Weight *W , Index k , Weight *V ,
+		ZeroOne *X , Index *NS );
+
+/* The body of the t-th worker thread during Solve(). */
+
+/*--------------------------------------------------------------------------*/
+/*----------------------- PRIVATE DATA STRUCTURES  -------------------------*/
+/*--------------------------------------------------------------------------*/
+
+   Index nvar;           // number of variables
+   unsigned int NThr;    // number of worker threads
+   unsigned int NAct;    // number of worker threads in the current Solve()
+
+   Solver **Slv;         // the solvers, one per worker
+
+   void *Rng;            // the ranges of instances of the workers and their
+                         // locks: it is defined "void *" to avoid having
+                         // to include <mutex> in the header file
+   void *Err;            // the first exception thrown by a worker, if any
+
+/*--------------------------------------------------------------------------*/
+
+ };  // end( class VS01PBatchT )
+
+/*--------------------------------------------------------------------------*/
+
+ typedef VS01PBatchT<> VS01PBatch;
+
+/**< The batch solver for the "classical" VerySimple01Problem. */
+
+/*--------------------------------------------------------------------------*/
+/*-------------------------- CLASS VS01PSplitT -----------------------------*/
+/*--------------------------------------------------------------------------*/
+/** Enumerates the solutions of a single VS01P in nonincreasing order of
+    the objective function value, like VerySimple01ProblemT::GetNextK(),
+    but using several threads.
+
+    The enumeration tree is split by fixing the first p variables in the
+    order of nondecreasing | w[ i ] |, i.e., the ones with the smallest
+    weights, to each of their 2^p possible values. The problem being
+    separable, each of the 2^p resulting subtrees is the enumeration tree of
+    the same "residual" VS01P on the other n - p variables, shifted by the
+    (negative) change in value of the fixed variables w.r.t. the optimal
+    solution; since the smallest weights are fixed, the shifts are all
+    close, and all the subtrees contribute to the best solutions. The 2^p
+    subtrees are dealt among the worker threads, each one of which
+    enumerates the residual VS01P with its own VerySimple01ProblemT (and
+    its own Q) and merges its own subtrees into a stream of solutions in
+    nonincreasing order. The streams of the workers are produced in
+    parallel rounds, in chunks, and k-way merged by value: all what is
+    above the largest among the last values produced by the workers can be
+    safely output. The solutions themselves are written in the output, in
+    parallel, by the workers that have produced them. The worker threads
+    are started at the first round and then wait on a condition variable
+    between the rounds, until the object is destroyed.
+
+    The output is the same sequence as that of
+    VerySimple01ProblemT::GetNextK(), up to the order of the solutions with
+    the same value; with floating point weights, values that are equal up
+    to rounding errors may also come out in a different order, since they
+    are computed as the sum of two different partial sums. */
+
+template< class Wght = double , class Indx = unsigned int ,
+	  class ZrOn = double >
+class VS01PSplitT : public VerySimple01ProblemBase
+{
+/*--------------------------------------------------------------------------*/
+/*----------------------- PUBLIC PART OF THE CLASS -------------------------*/
+/*--------------------------------------------------------------------------*/
+
+ public:
+
+/*--------------------------------------------------------------------------*/
+/*---------------------------- PUBLIC TYPES --------------------------------*/
+/*--------------------------------------------------------------------------*/
+/** @name Public Types
+    @{ */
+
+   typedef VerySimple01ProblemT< Wght , Indx , ZrOn > Solver;
+
+/**< The class of the solvers of the residual VS01P used by the workers. */
+
+   typedef typename Solver::Weight  Weight;
+   typedef typename Solver::Index   Index;
+   typedef typename Solver::ZeroOne ZeroOne;
+
+/**< The same as in VerySimple01ProblemT. */
+
+/*@} -----------------------------------------------------------------------*/
+/*--------------------- PUBLIC METHODS OF THE CLASS ------------------------*/
+/*--------------------------------------------------------------------------*/
+/*---------------------------- CONSTRUCTOR ---------------------------------*/
+/*--------------------------------------------------------------------------*/
+/** @name Constructor
+    @{ */
+
+   VS01PSplitT( Index n , unsigned int nthr = 0 , Index p = 0 );
+
+/**< Constructor of the class. The parameter "n" is the number of variables
+   in the VS01P, "nthr" is the number of worker threads (0 means one per
+   core, as reported by the system), "p" is the number of fixed variables.
+   p = 0 means that it is chosen automatically so that there are at least 8
+   subtrees per worker; in any case p is at most min( n , 20 ). */
+
+/*@} -----------------------------------------------------------------------*/
+/*-------------------------- OTHER INITIALIZATIONS -------------------------*/
+/*--------------------------------------------------------------------------*/
+/** @name Other initializations
+    @{ */
+
+   void SetWeights( const Weight *wght );
+
+/**< Set a new vector of weights, as in VerySimple01ProblemT::SetWeights();
+   the same rules about the retained pointer apply. */
+
+/*--------------------------------------------------------------------------*/
+
+   void SetQueue( QueueType qt );
+
+/**< Set the priority queue used by all the workers [see
+   VerySimple01ProblemT::SetQueue()]. SolveVS01P() has to be called
+   afterwards. */
+
+/*@} -----------------------------------------------------------------------*/
+/*---------------------- METHODS FOR SOLVING THE PROBLEM -------------------*/
+/*--------------------------------------------------------------------------*/
+/** @name Solving the problem
+    @{ */
+
+   void SolveVS01P( void );
+
+/**< (Re)starts the enumeration: the next solution produced by GetNextK()
+   will be the optimal one. */
+
+/*--------------------------------------------------------------------------*/
+
+   Index GetNextK( Index k , Weight *v , ZeroOne *x = 0 );
+
+/**< Get the next k best solutions, exactly as in
+   VerySimple01ProblemT::GetNextK(): their values go in the first k
+   positions of v, and if x is not 0 the solutions go in x, the h-th one
+   in the n positions starting from h * n. The return value is the number
+   of solutions actually produced, which is smaller than k only if all the
+   2^n solutions have been seen. Successive calls continue the same stream.
+
+   The workers produce their streams in chunks of about k / nthr solutions,
+   so that a few rounds suffice, and that a small k only costs as much: the
+   solutions produced but not output yet are kept for the next call. */
+
+/*--------------------------------------------------------------------------*/
+
+   inline unsigned long NSol( void ) const;
+
+/**< Returns the number of solutions enumerated so far. */
+
+/*@} -----------------------------------------------------------------------*/
+/*------------------- METHODS FOR READING THE DATA -------------------------*/
+/*--------------------------------------------------------------------------*/
+/** @name Reading the data of the class
+    @{ */
+
+   inline Index Getn( void ) const;
+
+   inline unsigned int GetNThr( void ) const;
+
+   inline Index GetNFix( void ) const;
+
+/* Getn() returns the number of variables, GetNThr() the number of worker
+   threads and GetNFix() the number p of fixed variables. */
+
+/*@} -----------------------------------------------------------------------*/
+/*------------------------------ DESTRUCTOR --------------------------------*/
+/*--------------------------------------------------------------------------*/
+/** @name Destructor
+    @{ */
+
+   ~VS01PSplitT();
+
+/*@} -----------------------------------------------------------------------*/
+/*-------------------- PRIVATE PART OF THE CLASS ---------------------------*/
+/*--------------------------------------------------------------------------*/
+
+ private:
+
+/*--------------------------------------------------------------------------*/
+/*-------------------------- PRIVATE METHODS -------------------------------*/
+/*--------------------------------------------------------------------------*/
+
+   void Phase( Index c , ZeroOne *x );
+
+/* Run the workers in parallel: each one writes in x the solutions it has
+   been assigned by the last merge, and then produces at least c more. */
+
+   void Work( unsigned int t , Index c , ZeroOne *x );
+
+/* The work of the t-th worker during Phase(). */
+
+   void Loop( unsigned int t );
+
+/* The body of the t-th worker thread, t >= 1: run Work() in each phase,
+   until the destructor. */
+
+   Index Merge( Index h , Index k , Weight *v , bool wx );
+
+/* Merge the streams of the workers, writing the values from v[ h ] on,
+   up to v[ k - 1 ]; returns the new h. */
+
+/*--------------------------------------------------------------------------*/
+/*----------------------- PRIVATE DATA STRUCTURES  -------------------------*/
+/*--------------------------------------------------------------------------*/
+
+   Index nvar;           // number of variables
+   unsigned int NThr;    // number of worker threads
+   Index NFix;           // number of fixed variables
+
+   const Weight *w;      // vector of weights
+   Index *ord;           // the variables in nondecreasing order of | w[ i ] |
+   Weight *RW;           // the weights of the residual VS01P, i.e.,
+                         // RW[ i ] = w[ ord[ NFix + i ] ]
+
+   unsigned long nsol;   // number of solutions generated so far
+   bool More;            // false if all the solutions have been seen
+
+   void *Wrk;            // the state of the workers: it is defined "void *"
+                         // to avoid having to show it in the header file
+   void *Pool;           // the same for their threads
+
+/*--------------------------------------------------------------------------*/
+
+ };  // end( class VS01PSplitT )
+
+/*--------------------------------------------------------------------------*/
+
+ typedef VS01PSplitT<> VS01PSplit;
+
+/**< The split solver for the "classical" VerySimple01Problem. */
+
+/*--------------------------------------------------------------------------*/
+/*------------------- inline methods implementation ------------------------*/
+/*--------------------------------------------------------------------------*/
+
+template< class Wght , class Indx , class ZrOn >
+inline typename VS01PBatchT< Wght , Indx , ZrOn >::Index
+VS01PBatchT< Wght , Indx , ZrOn >::Getn( void ) const
+{
+ return( nvar );
+ }
+
+/*--------------------------------------------------------------------------*/
+
+template< class Wght , class Indx , class ZrOn >
+inline unsigned int VS01PBatchT< Wght , Indx , ZrOn >::GetNThr( void ) const
+{
+ return( NThr );
+ }
+
+/*--------------------------------------------------------------------------*/
+
+template< class Wght , class Indx , class ZrOn >
+inline unsigned long VS01PSplitT< Wght , Indx , ZrOn >::NSol( void ) const
+{
+ return( nsol );
+ }
+
+/*--------------------------------------------------------------------------*/
+
+template< class Wght , class Indx , class ZrOn >
+inline typename VS01PSplitT< Wght , Indx , ZrOn >::Index
+VS01PSplitT< Wght , Indx , ZrOn >::Getn( void ) const
+{
+ return( nvar );
+ }
+
+/*--------------------------------------------------------------------------*/
+
+template< class Wght , class Indx , class ZrOn >
+inline unsigned int VS01PSplitT< Wght , Indx , ZrOn >::GetNThr( void ) const
+{
+ return( NThr );
+ }
+
+/*--------------------------------------------------------------------------*/
+
+template< class Wght , class Indx , class ZrOn >
+inline typename VS01PSplitT< Wght , Indx , ZrOn >::Index
+VS01PSplitT< Wght , Indx , ZrOn >::GetNFix( void ) const
+{
+ return( NFix );
+ }
+
+/*--------------------------------------------------------------------------*/
+
+ };  // end( namespace VS01P_di_unipi_it )
+
+/*--------------------------------------------------------------------------*/
+/*--------------------------------------------------------------------------*/
+
+#endif  /* VS01PPar.h included */
+
+/*--------------------------------------------------------------------------*/
+/*---------------------- End File VS01PPar.h -------------------------------*/
+/*--------------------------------------------------------------------------*/
@@ -38,6 +38,7 @@
 /*--------------------------------------------------------------------------*/
 
 #include <exception>
+#include <climits>
 
 /*--------------------------------------------------------------------------*/
 /*------------------------ NAMESPACE and USINGS ----------------------------*/
@@ -53,7 +54,147 @@ namespace VS01P_di_unipi_it
  using namespace std;
 
 /*--------------------------------------------------------------------------*/
-/*--------------------- CLASS VerySimple01Problem --------------------------*/
+/*------------------- CLASS VerySimple01ProblemBase ------------------------*/
+/*--------------------------------------------------------------------------*/
+/** The (non-template) base class of all the VerySimple01ProblemT, holding
+    the few things that do not depend on the types of the weights, the
+    indices and the variables, so that they are the same for all of them:
+    in particular, VS01Pexception can be caught without knowing which
+    VerySimple01ProblemT has thrown it. */
+
+class VerySimple01ProblemBase
+{
+ public:
+
+/*--------------------------------------------------------------------------*/
+/*---------------------------- PUBLIC TYPES --------------------------------*/
+/*--------------------------------------------------------------------------*/
+/** @name Public Types
+    @{ */
+
+   typedef unsigned long long PWord;
+
+/**< Type of the words of a packed solution [see GetPackedSol()]: variable
+   i is the bit i % 64 of word i / 64, so a solution takes NWords( n ) words
+   and the unused bits of the last word are always 0. */
+
+/*--------------------------------------------------------------------------*/
+
+   enum QueueType { kBinaryHeap = 0 ,
+                    kFourAryHeap ,
+                    kRadixHeap
+                    };
+
+/**< Possible implementations of the priority queue Q of the nodes of the
+   enumeration tree [see SetQueue()]:
+
+   - kBinaryHeap: a classical binary heap;
+
+   - kFourAryHeap: a 4-ary heap, which is shallower and more cache-friendly
+     than the binary one; this is the default for floating point weights;
+
+   - kRadixHeap: a radix heap, which takes advantage of the fact that the
+     values extracted from Q are monotone, so that each entry is moved
+     O(1) times (at most the number of bits of the keys) irrespectively of
+     the size of Q; this is the default for integer weights, where many
+     entries have the same key and the radix heap is about twice as fast
+     as the d-ary ones. */
+
+/*--------------------------------------------------------------------------*/
+
+   enum StatPhase { kSortPhase = 0 ,
+                    kNodePhase ,
+                    kQueuePhase ,
+                    kSolPhase ,
+                    kNumPhases
+                    };
+
+/**< The phases of the enumeration whose cost is measured when statistics
+   are collected [see Statistics]:
+
+   - kSortPhase: sorting the variables by nondecreasing | w[ i ] |, which
+     is done once after SetWeights();
+
+   - kNodePhase: creating the nodes of the enumeration tree and recycling
+     those no longer needed, while moving from a solution to the next;
+
+   - kQueuePhase: the operations on Q (spilling included) while moving from
+     a solution to the next;
+
+   - kSolPhase: climbing the tree to write down a solution in GetSol(),
+     GetPackedSol(), GetNextK() and GetNextKPacked(). */
+
+/*--------------------------------------------------------------------------*/
+
+   struct Statistics {
+    unsigned long NodesNew;    // nodes of the enumeration tree created
+    unsigned long NodesFreed;  // nodes recycled
+    unsigned long MaxQSize;    // the largest size of Q
+    unsigned long Climbs;      // solutions written by climbing the tree
+    unsigned long SumDepth;    // total number of nodes climbed in them
+    unsigned long MaxDepth;    // the most nodes climbed for one solution
+    unsigned long long Ticks[ kNumPhases ];  // cumulative ticks per phase
+    };
+
+/**< Statistics about the enumeration [see GetStats()]. They are only
+   collected if VrySmplP.C is compiled with the macro VS01P_STATS defined
+   to a nonzero value (e.g., -DVS01P_STATS=1); otherwise they are never
+   touched, hence always 0, and collecting them costs nothing. The layout
+   of the class does not depend on the macro, so the rest of the program
+   need not be compiled with it.
+
+   The ticks are CPU cycles (the time stamp counter) on x86 and
+   nanoseconds elsewhere; reading the clock takes some tens of cycles,
+   which is charged to the phases, and it is done a few times per
+   solution, so that the enumeration is noticeably slower when statistics
+   are collected. The mean depth of the climbs is SumDepth / Climbs. The
+   nodes read by LoadState() count as created, so that NodesNew -
+   NodesFreed is always NNodes() if ResetStats() is only called when the
+   tree is empty, e.g., before SolveVS01P(). */
+
+/*--------------------------------------------------------------------------*/
+
+   class VS01Pexception : public exception {
+
+/**< Small class for exceptions. Derives from std::exception implementing
+   the virtual method what() - and since what is virtual, remember to
+   always catch it by reference (catch VS01Pexception &e) if you want
+   the thing to work. */
+
+   public:
+    VS01Pexception( const char *const msg = 0 ) { errmsg = msg; }
+
+    const char* what( void ) const throw () { return( errmsg ); }
+
+   private:
+    const char *errmsg;
+   };
+
+/*@} -----------------------------------------------------------------------*/
+/*------------------------- PACKED SOLUTIONS -------------------------------*/
+/*--------------------------------------------------------------------------*/
+/** @name Packed solutions
+    @{ */
+
+   static inline unsigned int NWords( unsigned int n );
+
+/**< Returns the number of PWords in a packed solution with n variables. */
+
+/*--------------------------------------------------------------------------*/
+
+   static unsigned int PackedDist( const PWord *xp , const PWord *yp ,
+                                   unsigned int n );
+
+/**< Returns the Hamming distance between the packed solutions xp and yp of
+   n variables, i.e., the number of variables having different value in the
+   two. */
+
+/*@} -----------------------------------------------------------------------*/
+
+ };  // end( class VerySimple01ProblemBase )
+
+/*--------------------------------------------------------------------------*/
+/*-------------------- CLASS VerySimple01ProblemT --------------------------*/
 /*--------------------------------------------------------------------------*/
 /*--------------------------- GENERAL NOTES --------------------------------*/
 /*--------------------------------------------------------------------------*/
@@ -147,9 +288,23 @@ namespace VS01P_di_unipi_it
     root gives the list of all and only variables than need to be flipped
     w.r.t. x^*, and those variables are even ordered). Since k is no more
     than 2^n, the overall complexity of generating a new solution is O(n).
-    */
 
-class VerySimple01Problem
+    In practice, the nodes that are no longer in Q and have no descendants
+    in Q are recycled (reference counting), and Q itself can be capped in
+    size by spilling its worst part to a file [see SetMaxQueue()], so that
+    very long enumerations can be run in bounded memory.
+
+    The class is a template over the types of the weights, of the indices
+    and of the variables, so that, e.g., integer and floating point
+    instances can live in the same program; integer weights are handled
+    exactly, ties included. The implementation is not in the header, but
+    the class is explicitly instantiated in VrySmplP.C for Weight = double,
+    float, int and long long (with Index = unsigned int and ZeroOne =
+    double); VerySimple01Problem is the one with double weights. */
+
+template< class Wght = double , class Indx = unsigned int ,
+          class ZrOn = double >
+class VerySimple01ProblemT : public VerySimple01ProblemBase
 {
 
 /*--------------------------------------------------------------------------*/
@@ -164,46 +319,24 @@ class VerySimple01Problem
 /** @name Public Types
     @{ */
 
-   typedef double Weight;
+   typedef Wght Weight;
 
-/**< Type of the weights w[ i ]. By changing this definition and recompiling
-   the code works with whatever base type is chosen. It may have been set as
-   a template, but it seemed overkill. */
+/**< Type of the weights w[ i ]: any signed integer or floating point type
+   works. */
 
 /*- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -*/
 
-   typedef unsigned int Index;
+   typedef Indx Index;
 
-/**< Type of the indices "i" in "w[ i ]", "x[ i ]". By changing this
-   definition and recompiling the code works with whatever base type is
-   chosen. It may have been set as a template, but it seemed overkill. */
+/**< Type of the indices "i" in "w[ i ]", "x[ i ]": any unsigned integer
+   type works. */
 
 /*- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -*/
 
-   typedef double ZeroOne;
+   typedef ZrOn ZeroOne;
 
 /**< Type of the variables x[ i ]: must be large enough to hold both values
-   0 and 1 (is there any type which can not?). By changing this definition
-   and recompiling the code works with whatever base type is chosen. It may
-   have been set as a template, but it seemed overkill. */
-
-/*--------------------------------------------------------------------------*/
-
-   class VS01Pexception : public exception {
-
-/**< Small class for exceptions. Derives from std::exception implementing
-   the virtual method what() - and since what is virtual, remember to
-   always catch it by reference (catch VS01Pexception &e) if you want
-   the thing to work. */
-
-   public:
-    VS01Pexception( const char *const msg = 0 ) { errmsg = msg; }
-
-    const char* what( void ) const throw () { return( errmsg ); }
-
-   private:
-    const char *errmsg;
-   };
+   0 and 1 (is there any type which can not?). */
 
 /*@} -----------------------------------------------------------------------*/
 /*--------------------- PUBLIC METHODS OF THE CLASS ------------------------*/
@@ -213,7 +346,7 @@ class VerySimple01Problem
 /** @name Constructor
     @{ */
 
-   VerySimple01Problem( Index n );
+   VerySimple01ProblemT( Index n );
 
 /**< Constructor of the class. The parameter "n" is the number of variables
    in the VS01P. */
@@ -240,6 +373,88 @@ class VerySimple01Problem
    This method has to be called at least once if any method in the
    following sections is to be called. */
 
+/*--------------------------------------------------------------------------*/
+
+   void UpdateWeights( Index m , const Index *idx , const Weight *nwght );
+
+/**< Change only some of the weights: w[ idx[ j ] ] becomes nwght[ j ] for
+   j = 0, ..., m - 1. Like SetWeights(), this restarts the generating process
+   anew, so SolveVS01P() has to be called afterwards, but the information
+   that does not depend on the single weights is not thrown away: OptVal is
+   updated by the change in the weights, and the order of the variables by
+   nondecreasing | w[ i ] | is repaired by moving each changed variable to
+   its new place (a binary search, plus shifting the variables it moves
+   past), rather than sorting all of them again. The memory of Q and of the
+   enumeration tree is kept for reuse, as always. Thus, if m is small
+   w.r.t. n, re-solving costs much less than after SetWeights().
+
+   Since the vector passed to SetWeights() is read-only, at the first call
+   after SetWeights() the class makes a private copy of the weights, and
+   uses it from then on: the caller's vector is not changed, and it is no
+   longer in use by the class. It is up to the caller to mirror the changes
+   in its own copy of the weights, if it needs them.
+
+   Throws, without changing anything, if SetWeights() has never been called
+   or if some idx[ j ] >= n.
+
+   @note OptVal is updated by differences, hence with floating point weights
+         it may drift (by rounding errors) from the sum of the positive
+         weights after many updates; a call to SetWeights() computes it
+         anew. */
+
+/*--------------------------------------------------------------------------*/
+
+   void SetQueue( QueueType qt );
+
+/**< Set the implementation of the priority queue Q used in the enumeration
+   of the solutions [see QueueType above]. Since changing it restarts the
+   generating process anew, SolveVS01P() has to be called afterwards. */
+
+/*--------------------------------------------------------------------------*/
+
+   void SetGap( Weight gap );
+
+/**< Restrict the enumeration to the solutions whose value is at least
+   OptVal - gap, where OptVal is the optimal value: after the last of them
+   has been produced, GetVal() throws exactly as if all the 2^n solutions
+   had been seen [see also MoreSol()]. This is not just a filter: the nodes
+   of the enumeration tree below the cutoff, and therefore whole subtrees,
+   are never created and never enter Q. A negative gap, which is the
+   default, means no restriction.
+
+   SetGap() can be called at any time; however, the nodes already pruned
+   can not be brought back, so during the enumeration the gap can only be
+   reduced, while an increase only takes effect at the next call to
+   SolveVS01P(). */
+
+/*--------------------------------------------------------------------------*/
+
+   void SetMaxSol( unsigned long k );
+
+/**< Restrict the enumeration to the best k solutions (the optimal one
+   included): after the k-th one GetVal() throws as if all the solutions
+   had been seen, and GetNextK() stops there. k == 0, which is the default,
+   means no restriction. This can be freely combined with SetGap(), and
+   changed at any time. */
+
+/*--------------------------------------------------------------------------*/
+
+   void SetMaxQueue( unsigned long m );
+
+/**< Set a cap on the number of nodes resident in Q (0, the default, means
+   no cap; otherwise, it is at least 16). Whenever Q grows larger than m,
+   the nodes in it are sorted and all but the best m / 2 are spilled to a
+   temporary file, as a "run" in nonincreasing order of value; each node is
+   written as the list of the variables flipped in it (their positions in
+   the order of the variables), so that it and all its ancestors that have
+   no other descendants alive can be recycled. The spilled nodes are read
+   back (m / 4 at a time, through a memory map of the file) only when the
+   best of them is better than the best node in Q, rebuilding their paths
+   from the root; the file shrinks back to nothing each time all the runs
+   have been read back. This trades some time (all the spilled nodes are
+   written and read once) for a memory footprint that only depends on m and
+   on the depth of the tree, rather than on the number of solutions. */
+
 /*@} -----------------------------------------------------------------------*/
 /*---------------------- METHODS FOR SOLVING THE PROBLEM -------------------*/
 /*--------------------------------------------------------------------------*/
@@ -275,7 +490,8 @@ class VerySimple01Problem
    be returned as many times as there are solutions.
 
    @note This method must not be called more than 2^n times, as there are
-         "only" that many different solutions. */
+         "only" that many different solutions, or more times than allowed
+         by SetGap() and SetMaxSol(): MoreSol() tells whether it can. */
 
 /*--------------------------------------------------------------------------*/
 
@@ -297,10 +513,332 @@ class VerySimple01Problem
 
 /*--------------------------------------------------------------------------*/
 
-   inline Index NSol( void ) const;
+   Index GetFlips( Index *f ) const;
+
+/**< Get the current solution (the same that GetSol() would return) in
+   sparse format, i.e., as the list of the variables whose value differs
+   from that they have in the optimal solution x^* (the first one returned
+   by GetSol(), where x^*[ i ] = 1 if and only if w[ i ] > 0). The indices
+   of these variables are written in f, ordered by nonincreasing | w[ i ] |,
+   and their number is returned. The cost is proportional to that number,
+   rather than to n, so f need not be larger than n but is hardly ever
+   filled. */
+
+/*--------------------------------------------------------------------------*/
+
+   Index GetDiff( Index *f ) const;
+
+/**< Like GetFlips(), but the variables written in f are those whose value
+   in the current solution differs from that in the previous one, i.e., the
+   solution corresponding to the next-to-last call to GetVal() (the optimal
+   one at the first two calls). Thus, one who keeps a copy of the previous
+   solution can update it by flipping the returned variables. The cost is
+   proportional to the number of variables flipped in either of the two
+   solutions w.r.t. x^*, and usually much less than that. Note that if
+   GetNextK() is used, "the previous solution" is the next-to-last one it
+   has produced. */
+
+/*--------------------------------------------------------------------------*/
+
+   Index GetNextK( Index k , Weight *v , ZeroOne *x = 0 );
+
+/**< Get the next k best solutions in one blow: this amounts to calling k
+   times GetVal() and GetSol(), but it is faster since all the work on Q is
+   done with no per-solution overhead. The values of the solutions are
+   written in the first k positions of v, in nonincreasing order. If x is
+   not 0, the solutions are written in x, one after the other: the h-th one
+   (h = 0, ..., k - 1) in the n positions of x starting from h * n, so x
+   must have room for k * n elements.
+
+   The return value is the number of solutions actually produced, which can
+   be smaller than k if all the 2^n solutions (or all those allowed by
+   SetGap() and SetMaxSol()) have been seen; unlike
+   GetVal(), no exception is thrown in this case.
+
+   GetNextK() can be freely mixed with GetVal() and GetSol(): after it
+   returns, GetSol() returns the last solution written in x. */
+
+/*--------------------------------------------------------------------------*/
+
+   Weight SkipTo( unsigned long k );
+
+/**< Jump to the k-th best solution (k >= 1, the optimal one being the
+   first) and return its value: afterwards, the state is as if GetVal() had
+   been called k times, i.e., GetSol(), GetFlips() and GetDiff() refer to
+   the k-th solution (GetDiff() w.r.t. the (k - 1)-th one), and the next
+   GetVal() produces the (k + 1)-th. Among solutions with the same value
+   the order may differ from that GetVal() would have produced, but the
+   values are the same. If k <= NSol() the enumeration is restarted.
+
+   The solutions in between are not materialized: the value of the
+   (k - 1)-th solution is found by counting [see GetKth()], then a
+   depth-first visit from the nodes in Q rebuilds the frontier of the
+   enumeration at that point, only creating the nodes that end up in Q (and
+   their ancestors) and skipping without visiting the subtrees entirely
+   above that value. Since the frontier itself may have about k nodes the
+   cost is still roughly linear in k - NSol(), but with a smaller constant
+   than calling GetVal() as many times; if the enumeration need not be
+   continued, GetKth() is much cheaper. Any spilled node [see
+   SetMaxQueue()] is read back first. With floating-point weights the last
+   few solutions before the k-th one are produced as usual.
+
+   Throws if there are less than k solutions (or less than allowed by
+   SetGap() and SetMaxSol()); the enumeration can then be continued from
+   where it was (from the start if k <= NSol()). */
+
+/*--------------------------------------------------------------------------*/
+
+   Weight GetKth( unsigned long k , ZeroOne *x = 0 );
+
+/**< Returns the value of the k-th best solution (k >= 1, the optimal one
+   being the first) and, if x is not 0, writes in x (n elements) a
+   solution with that value, which need not be the k-th one GetVal() would
+   produce if other solutions have the same value. The enumeration is not
+   affected, and it need not have started yet; SetGap() and
+   SetMaxSol() are taken into account. Throws if there are less than k
+   solutions.
+
+   No solution is enumerated: the number of those with value >= t is
+   counted by a depth-first visit that flips the variables in
+   nonincreasing order of | w[ i ] |, so that most subtrees are counted in
+   closed form without visiting them, and the value is found by bisection
+   on t. With integer weights, the counts for all the values are rather
+   computed by dynamic programming if the range of values involved is not
+   too large, which makes the cost independent of k. With floating-point
+   weights the value may differ in the last bits from the one GetVal()
+   would return. */
+
+/*--------------------------------------------------------------------------*/
+
+   Weight GetNextClass( void );
+
+/**< Tie-aware enumeration: returns the next distinct value of the
+   solutions, in nonincreasing order, making all the solutions with that
+   value the current "class" [see ClassSize(), GetClass() and
+   GetClassSol()]. When many solutions have the same value, as it is
+   typical with integer weights, this is much faster than calling GetVal()
+   once for each of them, since the work is proportional to the number of
+   "count vectors" [see GetClass()] rather than to that of solutions.
+
+   The variables with w[ i ] != 0 are partitioned into groups with equal
+   | w[ i ] | [see NGroups()], and a count vector says how many variables
+   of each group are flipped w.r.t. x^*; all the solutions with the same
+   count vector, and any setting of the variables with w[ i ] == 0, have
+   the same value. The count vectors are visited best-first in a tree akin
+   to that of GetVal(), each node having at most three sons, and all those
+   with the value of the best one in the queue form the class.
+
+   This enumeration is independent from that of GetVal(), with which it
+   can be freely mixed; it is restarted by SolveVS01P() (and by all that
+   restart the enumeration). SetGap() is taken into account when it
+   (re)starts, SetMaxSol() and SetMaxQueue() are not, and it is not saved
+   by SaveState(). Values are compared exactly, so with floating-point
+   weights solutions whose values only differ by rounding may end up in
+   different classes. Throws if all the classes have been seen. */
+
+/*--------------------------------------------------------------------------*/
+
+   bool MoreClass( void );
+
+/**< Returns true if the next call to GetNextClass() will produce a class,
+   i.e., if not all the classes have been seen yet. */
+
+/*--------------------------------------------------------------------------*/
+
+   unsigned long ClassSize( void ) const;
+
+/**< Returns the number of solutions in the current class, or ULONG_MAX if
+   it is not smaller. */
+
+/*--------------------------------------------------------------------------*/
+
+   Index NGroups( void );
+
+   Index GetGroup( Index g , Index *vars = 0 , Weight *wg = 0 );
+
+/**< NGroups() returns the number G of groups of variables with equal
+   | w[ i ] | != 0, and GetGroup() returns the size of group
+   g = 0 , ... , G - 1, writing in vars (if not 0) its variables and in wg
+   (if not 0) their | w[ i ] |. The groups are ordered by increasing
+   | w[ i ] |, and the variables with w[ i ] == 0 are in none of them. */
+
+/*--------------------------------------------------------------------------*/
+
+   Index GetClass( Index *cnt = 0 ) const;
+
+/**< Returns the number of count vectors of the current class and, if cnt
+   is not 0, writes them in cnt, one after the other, each one taking
+   NGroups() elements: a solution is in the class if and only if, for some
+   count vector, exactly cnt[ g ] variables of each group g are flipped
+   w.r.t. x^* (i.e., x[ i ] == 0 if w[ i ] > 0 and x[ i ] == 1 if
+   w[ i ] < 0), whatever the variables with w[ i ] == 0 are. The number of
+   such solutions is the product of the binomial coefficients
+   C( | g | , cnt[ g ] ), times 2 to the number of w[ i ] == 0. */
+
+/*--------------------------------------------------------------------------*/
+
+   void GetClassSol( unsigned long j , ZeroOne *x ) const;
+
+/**< Writes in x (n elements) the j-th solution of the current class,
+   j = 0 , ... , ClassSize() - 1, so that all the solutions of the class
+   can be produced on demand, each one in O( n^2 ) at worst (O( n ) when
+   the groups are small). The order is fixed but unspecified. */
+
+/*--------------------------------------------------------------------------*/
+
+   inline unsigned long NSol( void ) const;
 
 /**< Returns the number of solutions enumerated so far. */
 
+/*--------------------------------------------------------------------------*/
+
+   inline unsigned long NNodes( void ) const;
+
+/**< Returns the number of nodes of the enumeration tree currently alive,
+   i.e., those in Q, the ones of the current and previous solutions, and
+   all their ancestors; the others are recycled as soon as they are no
+   longer needed [see also SetMaxQueue()]. */
+
+/*--------------------------------------------------------------------------*/
+
+   inline unsigned long NPeakNodes( void ) const;
+
+/**< Returns the largest number of nodes alive at the same time since the
+   enumeration started, i.e., the number of nodes actually allocated: the
+   memory taken by the tree is that times sizeof( Weight ) +
+   sizeof( Index ) + 2 * sizeof( NodeIdx ). */
+
+/*--------------------------------------------------------------------------*/
+
+   inline unsigned long NQueueOps( void ) const;
+
+/**< Returns the number of insertions in and extractions from Q done since
+   the enumeration started to move from a solution to the next (those due
+   to spilling [see SetMaxQueue()] are not counted). Keeping it costs one
+   addition per solution; together with NSol() and NPeakNodes(), it is
+   meant for benchmarking. */
+
+/*--------------------------------------------------------------------------*/
+
+   inline const Statistics& GetStats( void ) const;
+
+/**< Returns the statistics collected since the object was constructed or
+   ResetStats() was last called; they are all 0 unless VrySmplP.C has been
+   compiled with VS01P_STATS [see Statistics]. */
+
+/*--------------------------------------------------------------------------*/
+
+   inline void ResetStats( void );
+
+/**< Sets all the statistics to 0. */
+
+/*--------------------------------------------------------------------------*/
+
+   bool MoreSol( void );
+
+/**< Returns true if the next call to GetVal() will produce a solution,
+   false if it would throw because all the solutions (or all those allowed
+   by SetGap() and SetMaxSol()) have been seen. This method can be called
+   only after SolveVS01P(). */
+
+/*--------------------------------------------------------------------------*/
+
+   unsigned long CountSol( Weight gap , unsigned long limit = ULONG_MAX );
+
+/**< Returns the number of solutions whose value is at least OptVal - gap,
+   or limit if there are more than that, without enumerating them in order;
+   so one can size the buffers before the enumeration starts, e.g., with
+   SetGap( gap ) and GetNextK(). It can be called any time after
+   SetWeights(), and does not change the state of the enumeration. As in
+   SetGap(), a negative gap means no restriction, so that the result is
+   min( 2^n , limit ).
+
+   The count is done by a depth-first visit of the same tree used by
+   GetVal(), except that the subtrees entirely above the cutoff are counted
+   without visiting them; hence, its cost is proportional to the number of
+   nodes on the "border" of the set of solutions, which is usually much
+   smaller than their number. The result is exact for integer weights; with
+   floating-point ones, solutions whose value is very close to the cutoff
+   may be counted differently than GetVal() does, since the sums are done
+   in a different order. */
+
+/*@} -----------------------------------------------------------------------*/
+/*------------------------- PACKED SOLUTIONS -------------------------------*/
+/*--------------------------------------------------------------------------*/
+/** @name Packed solutions
+    Solutions can also be produced in packed format, one bit per variable
+    [see PWord], which takes 64 times less memory than an array of double.
+    The packed solution is obtained by copying the (precomputed) packed
+    optimal solution and flipping the bits of the variables of GetFlips(),
+    hence it costs O( n / 64 ) plus the depth of the node. PackedVal()
+    works on any packed vector, and is written to be vectorized by the
+    compiler; see also VerySimple01ProblemBase::NWords() and
+    VerySimple01ProblemBase::PackedDist().
+    @{ */
+
+   void GetPackedSol( PWord *xp );
+
+/**< Like GetSol(), but the solution is written in packed format in the
+   first NWords( n ) positions of xp. */
+
+/*--------------------------------------------------------------------------*/
+
+   Index GetNextKPacked( Index k , Weight *v , PWord *xp );
+
+/**< Like GetNextK(), but the solutions are written in packed format: the
+   h-th one in the NWords( n ) positions of xp starting from h * NWords( n ).
+   */
+
+/*--------------------------------------------------------------------------*/
+
+   static Weight PackedVal( const Weight *wght , const PWord *xp , Index n );
+
+/**< Returns the objective function value w * x of the packed solution xp
+   w.r.t. the n weights in wght. The sum is computed with several partial
+   accumulators, hence with floating point weights it may differ in the last
+   bits from that computed in index order. */
+
+/*@} -----------------------------------------------------------------------*/
+/*---------------------------- CHECKPOINTS ---------------------------------*/
+/*--------------------------------------------------------------------------*/
+/** @name Checkpoints
+    The state of the enumeration can be saved to a binary file, and later
+    loaded back (also by another object, in another process) to continue
+    from where it was, rather than from the optimal solution.
+    @{ */
+
+   void SaveState( const char *fname );
+
+/**< Save the state of the enumeration to the file fname, which is created
+   (or overwritten): the weights (for checking), ord[], OptVal, nsol, the
+   gap and max number of solutions [see SetGap() and SetMaxSol()], the
+   nodes of the enumeration tree that are alive [see NNodes()], renumbered
+   contiguously, the contents of Q, and the spilled runs [see
+   SetMaxQueue()], if any. Hence, the size of the file is proportional to
+   that of the frontier of the enumeration (and the memory used), not to
+   the number of solutions generated so far. Throws if the file can not be
+   written. */
+
+/*--------------------------------------------------------------------------*/
+
+   void LoadState( const char *fname );
+
+/**< Load the state of the enumeration from the file fname, written by
+   SaveState(): after that, the next solution produced by GetVal() or
+   GetNextK() is the (nsol + 1)-th, and GetSol(), GetFlips() and GetDiff()
+   refer to the nsol-th. The file is memory-mapped, and the nodes are
+   copied in one blow, so the time is proportional to the size of the file.
+
+   SetWeights() must have been called with the same weights as when the
+   file was saved: this is checked, and an exception is thrown if they
+   differ, or if the file has not been written by a VerySimple01ProblemT
+   with the same n, Weight and Index. The indices in the file (of the
+   variables, of the nodes and of their fathers) are all checked before
+   anything is changed, and an exception is thrown if any of them is out
+   of range, in which case the object is left as it was. The type of Q
+   need not be the same, and the cap on its size is not saved, since they
+   are properties of the object rather than of the enumeration. */
+
 /*@} -----------------------------------------------------------------------*/
 /*-------------- METHODS FOR READING THE DATA OF THE PROBLEM ---------------*/
 /*--------------------------------------------------------------------------*/
@@ -315,7 +853,9 @@ class VerySimple01Problem
 
    Getn() returns the number of variables.
 
-   Getw() returns (a read-only pointer to) the weights vector. */
+   Getw() returns (a read-only pointer to) the weights vector; after
+   UpdateWeights() this is the private copy of the class, which contains the
+   updated weights. */
 
 /*@} -----------------------------------------------------------------------*/
 /*------------------------------ DESTRUCTOR --------------------------------*/
@@ -323,7 +863,7 @@ class VerySimple01Problem
 /** @name Destructor
     @{ */
 
-   ~VerySimple01Problem();
+   ~VerySimple01ProblemT();
 
 /**< Destructor of the class. */
 
@@ -351,20 +891,81 @@ class VerySimple01Problem
 /*-------------------------- PRIVATE TYPES ---------------------------------*/
 /*--------------------------------------------------------------------------*/
 
-/*--------------------------------------------------------------------------*/
-/*------------------------------ FRIENDS -----------------------------------*/
-/*--------------------------------------------------------------------------*/
+   typedef unsigned int NodeIdx;
 
-   friend struct ETNode;
-
-/* Node of the enumeration tree. This friend declaration serves as a
-   "forward declaration" that some VS01P_di_unipi_it::ETNode exists,
-   thus allowing the class to hold pointers to ETNodes. */
+/* Type of the "names" of the nodes of the enumeration tree, i.e., of their
+   position in the vectors NVal[], NFFree[] and NDad[]. 32 bits are plenty
+   (2^32 nodes means some 2^31 solutions), and make the tree half as large
+   as it would be with pointers. */
 
 /*--------------------------------------------------------------------------*/
 /*-------------------------- PRIVATE METHODS -------------------------------*/
 /*--------------------------------------------------------------------------*/
 
+   template< class QT >
+   inline void NextNode( QT &q );
+
+   template< class QT >
+   inline bool QMore( QT &q );
+
+   template< class QT >
+   void Spill( QT &q );
+
+   template< class QT >
+   void Reload( QT &q , bool all = false );
+
+/* Move curr to the next best node of the enumeration tree, creating its
+   sons and updating Q; this is the core of GetVal(), compiled once for
+   each type of Q so that the choice is made only once per call. */
+
+   template< class QT >
+   inline Index NextK( QT &q , Index k , Weight *v , ZeroOne *x ,
+                       PWord *xp );
+
+   inline Index BatchK( Index k , Weight *v , ZeroOne *x , PWord *xp );
+
+   bool FindKth( unsigned long r , Weight &lo , Weight &hi ,
+                 unsigned long &ngt , Weight *a , Weight *S );
+
+   unsigned long CountGE( Weight t , unsigned long cap , const Weight *a ,
+                          const Weight *S ) const;
+
+   template< class QT >
+   void SkipQ( QT &q , Weight vm , unsigned long nt );
+
+   inline NodeIdx SkipNode( void *stk , size_t t );
+
+/* Find the value of the r-th solution (lo <= it < hi, ngt solutions being
+   >= hi, lo == it and hi == lo + 1 with integer weights; false if there
+   are less than r), given room in a[] and S[] for the | w[ i ] | in
+   nonincreasing order and their suffix sums; count the solutions with
+   value >= t; advance the enumeration past those with value > vm (plus nt
+   with value vm) without producing them: these are the core of SkipTo()
+   and GetKth(). */
+
+   inline void WriteSol( ZeroOne *x ) const;
+
+   inline void WritePackedSol( PWord *xp );
+
+   inline void InitOpt( void );
+
+   inline void InitOrd( void );
+
+   inline void MoveVar( const Index i , const Weight nwi );
+
+   inline void SetCutoff( void );
+
+   inline void MakeQueue( void );
+
+   inline void DelQueue( void );
+
+   inline NodeIdx NewNode( const Weight v , const Index ff ,
+                           const NodeIdx dad );
+
+   void GrowNodes( NodeIdx nMax );
+
+   inline void Release( NodeIdx nde );
+
    inline void cleanup( void );
 
 /*--------------------------------------------------------------------------*/
@@ -373,51 +974,151 @@ class VerySimple01Problem
 
    Index nvar;           // number of variables
    const Weight *w;      // vector of arc weights
+   Weight *OwnW;         // the private copy of w[] used by UpdateWeights()
 
    Weight OptVal;        // objective function value of the optimal solution
+   bool OptOK;           // true if OptVal is up-to-date with w[]
+
+   Weight Gap;           // the gap set by SetGap(), < 0 if none
+   Weight Cutoff;        // OptVal - Gap, or the smallest Weight if no gap:
+                         // the nodes with value < Cutoff are not created
+   unsigned long MaxSol; // the max number of solutions, ULONG_MAX if none
 
    unsigned long nsol;   // number of solutions generated so far
 
    Index *ord;           // vector containing the order (permutation) of the
                          // variables (names) in nondecreasing sense of the
                          // absolute value of the corresponding w[ i ]
+   Index *pos;           // the inverse of ord[]: ord[ pos[ i ] ] == i
+   bool OrdOK;           // true if ord[] and pos[] are up-to-date with w[]
 
    void *Q;              // priority queue (heap) of the nodes of the
                          // enumeration tree created but not yet visited:
                          // it is defined "void *" to avoid having to
-                         // explicitly show the "less than" function in the
-                         // header file
+                         // explicitly show the heap classes in the header
+                         // file; the actual type depends on QType
+   QueueType QType;      // the type of Q
+
+   NodeIdx curr;         // node corresponding to the current solution
+   NodeIdx prev;         // node corresponding to the previous solution
+
+   Weight *NVal;         // the enumeration tree, stored as a struct of
+   Index *NFFree;        // vectors: NVal[ i ] is the objective function
+   NodeIdx *NDad;        // value of the solution corresponding to node i,
+   NodeIdx *NRef;        // NFFree[ i ] is the index (in the order of ord[])
+                         // of its first free variable, i.e., the first
+                         // NFFree[ i ] - 1 variables are fixed, NDad[ i ]
+                         // is its father and NRef[ i ] is the number of
+                         // references to it (by its sons, Q, curr and prev);
+                         // the root is node 0. A node with no references is
+                         // recycled, and NDad[] links the list of the free
+                         // ones; all the nodes are released in one blow by
+                         // cleanup(), which keeps the vectors for reuse
+
+   PWord *POpt;          // the optimal solution in packed format
+   bool POptOK;          // true if POpt[] is up-to-date with w[]
+
+   NodeIdx NNde;         // number of nodes ever used in the vectors
+   NodeIdx MaxNde;       // size of the vectors NVal[], NFFree[], NDad[] ...
+   NodeIdx FreeHd;       // head of the list of free nodes, 0 if none
+   unsigned long NLive;  // number of nodes alive
+   unsigned long NQOp;   // number of insertions in / extractions from Q
+   mutable Statistics Stats;  // statistics, only collected with
+                              // VS01P_STATS (also by const methods)
+
+   unsigned long MaxQ;   // the cap on the size of Q, 0 if none
+   unsigned long NSpill; // number of nodes currently spilled
+   void *Spl;            // the spill file: it is defined "void *" to avoid
+                         // having to show it in the header file
+   void *Cls;            // the enumeration of the classes [see
+                         // GetNextClass()], "void *" for the same reason
 
-   struct ETNode *curr;  // node corresponding to the current solution
+/*--------------------------------------------------------------------------*/
 
-   struct ETNode *CUList;// head of the singly-linked list containing all the
-                         // nodes of the enumeration tree created so far (for
-                         // cleanup purposes)
+ };  // end( class VerySimple01ProblemT )
 
 /*--------------------------------------------------------------------------*/
 
- };  // end( class VerySimple01Problem )
+ typedef VerySimple01ProblemT<> VerySimple01Problem;
+
+/**< The "classical" VerySimple01Problem, with double weights. */
 
 /*--------------------------------------------------------------------------*/
 /*------------------- inline methods implementation ------------------------*/
 /*--------------------------------------------------------------------------*/
 
-inline VerySimple01Problem::Index VerySimple01Problem::NSol( void ) const
+inline unsigned int VerySimple01ProblemBase::NWords( unsigned int n )
+{
+ return( ( n + 63 ) / 64 );
+ }
+
+/*--------------------------------------------------------------------------*/
+
+template< class Wght , class Indx , class ZrOn >
+inline unsigned long VerySimple01ProblemT< Wght , Indx , ZrOn >::NSol( void )
+ const
 {
  return( nsol );
  }
 
 /*--------------------------------------------------------------------------*/
 
-inline VerySimple01Problem::Index VerySimple01Problem::Getn( void ) const
+template< class Wght , class Indx , class ZrOn >
+inline unsigned long VerySimple01ProblemT< Wght , Indx , ZrOn >::NNodes( void )
+ const
+{
+ return( NLive );
+ }
+
+/*--------------------------------------------------------------------------*/
+
+template< class Wght , class Indx , class ZrOn >
+inline unsigned long
+VerySimple01ProblemT< Wght , Indx , ZrOn >::NPeakNodes( void ) const
+{
+ return( NNde );
+ }
+
+/*--------------------------------------------------------------------------*/
+
+template< class Wght , class Indx , class ZrOn >
+inline unsigned long
+VerySimple01ProblemT< Wght , Indx , ZrOn >::NQueueOps( void ) const
+{
+ return( NQOp );
+ }
+
+/*--------------------------------------------------------------------------*/
+
+template< class Wght , class Indx , class ZrOn >
+inline const VerySimple01ProblemBase::Statistics&
+VerySimple01ProblemT< Wght , Indx , ZrOn >::GetStats( void ) const
+{
+ return( Stats );
+ }
+
+/*--------------------------------------------------------------------------*/
+
+template< class Wght , class Indx , class ZrOn >
+inline void VerySimple01ProblemT< Wght , Indx , ZrOn >::ResetStats( void )
+{
+ Stats = Statistics();
+ }
+
+/*--------------------------------------------------------------------------*/
+
+template< class Wght , class Indx , class ZrOn >
+inline typename VerySimple01ProblemT< Wght , Indx , ZrOn >::Index
+VerySimple01ProblemT< Wght , Indx , ZrOn >::Getn( void ) const
 {
  return( nvar );
  }
 
 /*--------------------------------------------------------------------------*/
 
-inline const VerySimple01Problem::Weight* VerySimple01Problem::Getw( void )
-       const
+template< class Wght , class Indx , class ZrOn >
+inline const typename VerySimple01ProblemT< Wght , Indx , ZrOn >::Weight*
+VerySimple01ProblemT< Wght , Indx , ZrOn >::Getw( void ) const
 {
  return( w );
  }